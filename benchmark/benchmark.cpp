@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "frame_recorder.h"
+#include "brick_autosaver.h"
+#include "logger/logger.h"
+
+// Standalone micro-benchmarks for the CPU-side components, printed as JSON to stdout.
+// Kept out of src/ so it does not clash with the engine's main(); see README.md for the build command.
+constexpr uint32_t benchmark_seed = 1337;
+constexpr size_t benchmark_sizes[] = {1'000, 10'000, 100'000};
+constexpr size_t log_message_lengths[] = {10, 100, 1'000};
+constexpr uint32_t brick_storage_sizes[] = {100'000, 10'000'000, 1u << 30};
+constexpr uint32_t brick_material_counts[] = {1, 4, 256};
+
+struct BenchmarkResult {
+        std::string name;
+        const char* size_name;
+        size_t size;
+        size_t iterations;
+        double total_ms;
+};
+
+// Discards everything written to it so log_output can be measured without terminal I/O
+class NullBuffer : public std::streambuf {
+protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+template<typename Function>
+BenchmarkResult measure(const char* name, const char* size_name, size_t size, size_t iterations, Function function) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+                function(i);
+        auto end = std::chrono::steady_clock::now();
+        return {name, size_name, size, iterations, std::chrono::duration<double, std::milli>(end - start).count()};
+}
+
+DapperCraft::details::Brick syntheticBrick(uint32_t material_count) {
+        std::mt19937 rng(benchmark_seed);
+        std::uniform_int_distribution<uint32_t> distribution(0, material_count - 1);
+        DapperCraft::details::Brick brick;
+        for (auto &voxel: brick.voxels)
+                voxel = static_cast<uint8_t>(distribution(rng));
+        return brick;
+}
+std::vector<double> syntheticFrameTimes(size_t frame_count) {
+        std::mt19937 rng(benchmark_seed);
+        std::uniform_real_distribution<double> distribution(4.0, 20.0);
+        std::vector<double> frame_times_ms(frame_count);
+        for (auto &frame_time: frame_times_ms)
+                frame_time = distribution(rng);
+        return frame_times_ms;
+}
+
+void writeJson(const std::vector<BenchmarkResult> &results) {
+        std::printf("[\n");
+        for (size_t i = 0; i < results.size(); i++) {
+                const auto &result = results[i];
+                double ns_per_op = result.total_ms * 1'000'000.0 / static_cast<double>(result.iterations);
+                std::printf("\t{\"name\": \"%s\", \"%s\": %zu, \"iterations\": %zu, \"total_ms\": %.3f, \"ns_per_op\": %.1f, \"ops_per_sec\": %.1f}%s\n",
+                            result.name.c_str(), result.size_name, result.size, result.iterations, result.total_ms, ns_per_op, 1'000'000'000.0 / ns_per_op,
+                            i + 1 < results.size() ? "," : "");
+        }
+        std::printf("]\n");
+}
+
+int main() {
+        std::vector<BenchmarkResult> results;
+
+        // Engine logging goes to stderr so stdout stays pure JSON, and only the log_output loop is silenced,
+        // so FATAL messages from any other benchmark still reach the terminal
+        auto* cout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+        NullBuffer null_buffer;
+        std::cout.rdbuf(&null_buffer);
+        for (size_t message_length: log_message_lengths) {
+                std::string message(message_length, 'x');
+                results.emplace_back(measure("log_output", "message_length", message_length, 100'000, [&](size_t i) {
+                        log_output(LOG_LEVEL_TRACE, "%zu: %s", i, message.c_str());
+                }));
+        }
+        std::cout.rdbuf(std::cerr.rdbuf());
+
+        for (size_t size: benchmark_sizes) {
+                auto frame_times_ms = syntheticFrameTimes(size);
+                results.emplace_back(measure("compute_frame_statistics", "frame_count", size, 100, [&](size_t) {
+                        volatile double p99_ms = DapperCraft::details::computeFrameStatistics(frame_times_ms).p99_ms;
+                        (void) p99_ms;
+                }));
+        }
+
+        for (uint32_t material_count: brick_material_counts) {
+                auto brick = syntheticBrick(material_count);
+                std::vector<char> encoded;
+                results.emplace_back(measure("brick_encode", "material_count", material_count, 100'000, [&](size_t) {
+                        encoded.clear();
+                        DapperCraft::details::appendEncodedBrick(encoded, brick);
+                }));
+                DapperCraft::details::Brick decoded;
+                results.emplace_back(measure("brick_decode", "material_count", material_count, 100'000, [&](size_t) {
+                        const char* data = encoded.data();
+                        if (!DapperCraft::details::readEncodedBrick(data, encoded.data() + encoded.size(), decoded))
+                                FATAL("Failed to Decode Brick");
+                }));
+        }
+
+        // Snapshot cost must stay flat as the world grows, and edits after a snapshot stay bounded by the fixed-size root
+        for (uint32_t brick_count: brick_storage_sizes) {
+                DapperCraft::details::BrickStorage storage(brick_count);
+                std::mt19937 rng(benchmark_seed);
+                std::uniform_int_distribution<uint32_t> distribution(0, storage.brickCount() - 1);
+                auto brick = syntheticBrick(4);
+                results.emplace_back(measure("brick_storage_snapshot", "brick_count", storage.brickCount(), 10'000, [&](size_t) {
+                        volatile uint64_t version = storage.snapshot().version();
+                        (void) version;
+                }));
+                results.emplace_back(measure("brick_storage_set_brick_after_snapshot", "brick_count", storage.brickCount(), 10'000, [&](size_t) {
+                        auto snapshot = storage.snapshot();
+                        storage.setBrick(distribution(rng), brick);
+                }));
+        }
+
+        std::cout.rdbuf(cout_buffer);
+        writeJson(results);
+	return 0;
+}
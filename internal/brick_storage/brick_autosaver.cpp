@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "brick_autosaver.h"
+#include "logger/logger.h"
+
+// Each save appends one record: magic, record size, checksum of the body, then the body:
+// snapshot version, brick count, changed brick count, then per changed brick: index, brick version, encoded size, run-length encoded voxels
+constexpr char autosave_magic[4] = {'B', 'C', 'W', 'S'};
+constexpr size_t record_header_size = sizeof(autosave_magic) + sizeof(uint64_t) + sizeof(uint32_t);
+
+enum class RecordStatus {
+        eComplete,
+        eTruncated,
+        eCorrupt,
+};
+struct SavedBrick {
+        uint32_t index;
+        uint64_t version;
+        DapperCraft::details::Brick brick;
+};
+struct SaveScan {
+        RecordStatus status{RecordStatus::eComplete};
+        size_t valid_size{0};
+        uint32_t record_count{0};
+        uint32_t brick_count{0};
+};
+
+// Serialization helper functions
+template<typename T>
+void appendBytes(std::vector<char> &buffer, const T &value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+template<typename T>
+bool readBytes(const char* &data, const char* end, T &value) {
+        if (static_cast<size_t>(end - data) < sizeof(T))
+                return false;
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+}
+void DapperCraft::details::appendEncodedBrick(std::vector<char> &buffer, const Brick &brick) {
+        size_t size_offset = buffer.size();
+        appendBytes(buffer, uint32_t{0});
+        for (size_t i = 0; i < brick.voxels.size();) {
+                uint8_t value = brick.voxels[i];
+                uint8_t run = 0;
+                while (i < brick.voxels.size() && brick.voxels[i] == value && run < UINT8_MAX) {
+                        run++;
+                        i++;
+                }
+                buffer.push_back(static_cast<char>(run));
+                buffer.push_back(static_cast<char>(value));
+        }
+        auto encoded_size = static_cast<uint32_t>(buffer.size() - size_offset - sizeof(uint32_t));
+        std::memcpy(buffer.data() + size_offset, &encoded_size, sizeof(encoded_size));
+}
+bool DapperCraft::details::readEncodedBrick(const char* &data, const char* end, Brick &brick) {
+        uint32_t encoded_size = 0;
+        if (!readBytes(data, end, encoded_size) || encoded_size % 2 != 0 || encoded_size > static_cast<size_t>(end - data))
+                return false;
+
+        const char* encoded_end = data + encoded_size;
+        size_t voxel = 0;
+        for (; data < encoded_end; data += 2) {
+                auto run = static_cast<uint8_t>(data[0]);
+                if (run == 0 || run > brick.voxels.size() - voxel)
+                        return false;
+                std::memset(brick.voxels.data() + voxel, static_cast<uint8_t>(data[1]), run);
+                voxel += run;
+        }
+        return voxel == brick.voxels.size();
+}
+uint32_t checksum(const char* data, const char* end) {
+        uint32_t hash = 2166136261u;
+        for (; data < end; data++)
+                hash = (hash ^ static_cast<uint8_t>(*data)) * 16777619u;
+        return hash;
+}
+// Decodes one whole record, so a record cut short by a failed write is never partially applied.
+// Only a record that runs past the end of the file is reported as truncated, anything else that fails to parse is corrupt.
+RecordStatus readRecord(const char* &data, const char* end, uint32_t &brick_count, std::vector<SavedBrick> &bricks) {
+        auto remaining = static_cast<size_t>(end - data);
+        if (memcmp(data, autosave_magic, std::min(remaining, sizeof(autosave_magic))) != 0)
+                return RecordStatus::eCorrupt;
+        if (remaining < record_header_size)
+                return RecordStatus::eTruncated;
+
+        uint64_t record_size = 0;
+        uint32_t record_checksum = 0;
+        std::memcpy(&record_size, data + sizeof(autosave_magic), sizeof(record_size));
+        std::memcpy(&record_checksum, data + sizeof(autosave_magic) + sizeof(record_size), sizeof(record_checksum));
+        if (record_size < record_header_size)
+                return RecordStatus::eCorrupt;
+        if (record_size > remaining)
+                return RecordStatus::eTruncated;
+
+        const char* body = data + record_header_size;
+        const char* record_end = data + record_size;
+        if (checksum(body, record_end) != record_checksum)
+                return RecordStatus::eCorrupt;
+
+        uint64_t version = 0;
+        uint32_t changed_count = 0;
+        if (!readBytes(body, record_end, version) || !readBytes(body, record_end, brick_count) || !readBytes(body, record_end, changed_count))
+                return RecordStatus::eCorrupt;
+        bricks.clear();
+        for (uint32_t i = 0; i < changed_count; i++) {
+                SavedBrick &saved_brick = bricks.emplace_back();
+                if (!readBytes(body, record_end, saved_brick.index) || saved_brick.index >= brick_count)
+                        return RecordStatus::eCorrupt;
+                if (!readBytes(body, record_end, saved_brick.version) || saved_brick.version > version)
+                        return RecordStatus::eCorrupt;
+                if (!DapperCraft::details::readEncodedBrick(body, record_end, saved_brick.brick))
+                        return RecordStatus::eCorrupt;
+        }
+        if (body != record_end)
+                return RecordStatus::eCorrupt;
+        data = record_end;
+        return RecordStatus::eComplete;
+}
+// Walks records in order until one fails or a record's brick count differs from the first one's (reported as corrupt)
+template<typename Function>
+SaveScan scanRecords(const std::vector<char> &bytes, Function on_record) {
+        SaveScan scan;
+        const char* data = bytes.data();
+        const char* end = bytes.data() + bytes.size();
+        std::vector<SavedBrick> bricks;
+        while (data < end) {
+                uint32_t brick_count = 0;
+                scan.status = readRecord(data, end, brick_count, bricks);
+                if (scan.status == RecordStatus::eComplete && scan.record_count != 0 && brick_count != scan.brick_count)
+                        scan.status = RecordStatus::eCorrupt;
+                if (scan.status != RecordStatus::eComplete)
+                        break;
+                on_record(brick_count, bricks);
+                scan.brick_count = brick_count;
+                scan.valid_size = static_cast<size_t>(data - bytes.data());
+                scan.record_count++;
+        }
+        return scan;
+}
+// Encodes every brick of snapshot newer than saved; a default saved snapshot makes a full record.
+// Groups, tables and pages still shared with the base cannot contain newer bricks and are skipped. A full record is
+// diffed against an empty world, whose regions are shared with every untouched region, so it only visits edited pages.
+std::vector<char> buildRecord(const DapperCraft::details::BrickSnapshot &snapshot, const DapperCraft::details::BrickSnapshot &saved, uint32_t &changed_count) {
+        using namespace DapperCraft::details;
+        const BrickSnapshot base = saved.brickCount() == snapshot.brickCount() ? saved : BrickStorage(snapshot.brickCount()).snapshot();
+        std::vector<char> record;
+        changed_count = 0;
+        record.insert(record.end(), autosave_magic, autosave_magic + sizeof(autosave_magic));
+        appendBytes(record, uint64_t{0});
+        appendBytes(record, uint32_t{0});
+        appendBytes(record, snapshot.version());
+        appendBytes(record, snapshot.brickCount());
+        size_t changed_count_offset = record.size();
+        appendBytes(record, changed_count);
+
+        // 64-bit so a world near the full 32-bit brick index range cannot wrap to zero pages
+        auto page_count = static_cast<uint32_t>((static_cast<uint64_t>(snapshot.brickCount()) + bricks_per_page - 1) / bricks_per_page);
+        constexpr uint32_t pages_per_group = pages_per_table * tables_per_group;
+        for (uint32_t page_index = 0; page_index < page_count; page_index++) {
+                if (snapshot.group(page_index / pages_per_group) == base.group(page_index / pages_per_group)) {
+                        page_index += pages_per_group - 1 - page_index % pages_per_group;
+                        continue;
+                }
+                if (snapshot.table(page_index / pages_per_table) == base.table(page_index / pages_per_table)) {
+                        page_index += pages_per_table - 1 - page_index % pages_per_table;
+                        continue;
+                }
+                const BrickPage* page = snapshot.page(page_index);
+                if (page == base.page(page_index))
+                        continue;
+
+                for (uint32_t i = 0; i < bricks_per_page; i++) {
+                        uint64_t index = static_cast<uint64_t>(page_index) * bricks_per_page + i;
+                        if (index >= snapshot.brickCount() || page->versions[i] <= base.version())
+                                continue;
+                        appendBytes(record, static_cast<uint32_t>(index));
+                        appendBytes(record, page->versions[i]);
+                        appendEncodedBrick(record, page->bricks[i]);
+                        changed_count++;
+                }
+        }
+        std::memcpy(record.data() + changed_count_offset, &changed_count, sizeof(changed_count));
+
+        uint64_t record_size = record.size();
+        uint32_t record_checksum = checksum(record.data() + record_header_size, record.data() + record.size());
+        std::memcpy(record.data() + sizeof(autosave_magic), &record_size, sizeof(record_size));
+        std::memcpy(record.data() + sizeof(autosave_magic) + sizeof(record_size), &record_checksum, sizeof(record_checksum));
+        return record;
+}
+std::vector<char> readSaveFile(const std::string &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+                return {};
+        std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+}
+
+
+DapperCraft::details::BrickAutosaver::BrickAutosaver(std::string_view save_path, BrickSnapshot saved_snapshot, uint32_t max_records) : m_save_path(save_path), m_max_records(max_records), m_saved_snapshot(std::move(saved_snapshot)) {
+        TRACE("Initializing Brick Autosaver: %s...", m_save_path.c_str());
+        std::filesystem::remove(m_save_path + ".tmp");
+        auto bytes = readSaveFile(m_save_path);
+        auto scan = scanRecords(bytes, [](uint32_t, const std::vector<SavedBrick>&) {});
+
+        // Only a trailing record cut short by a crash is discarded; corruption anywhere else leaves the file untouched
+        if (scan.status == RecordStatus::eCorrupt)
+                FATAL("\t⎿ Corrupt Brick Save at Offset %zu: %s", scan.valid_size, m_save_path.c_str());
+        if (scan.status == RecordStatus::eTruncated)
+                WARN("\t⎿ Discarding %zu Bytes of Incomplete Trailing Record", bytes.size() - scan.valid_size);
+        m_saved_size = scan.valid_size;
+        m_saved_brick_count = scan.brick_count;
+        m_record_count = scan.record_count;
+
+        std::ofstream file(m_save_path, std::ios::binary | std::ios::app);
+        if (!file)
+                FATAL("\t⎿ Failed to Open Autosave: %s", m_save_path.c_str());
+        file.close();
+        if (scan.status == RecordStatus::eTruncated)
+                std::filesystem::resize_file(m_save_path, m_saved_size);
+
+        m_thread = std::thread(&BrickAutosaver::run, this);
+        TRACE("Initialized Brick Autosaver: %u Records", m_record_count);
+}
+DapperCraft::details::BrickAutosaver::~BrickAutosaver() {
+        TRACE("Destroying Brick Autosaver...");
+        {
+                std::lock_guard lock(m_mutex);
+                m_stopping = true;
+        }
+        m_condition.notify_one();
+        m_thread.join();
+        TRACE("Destroyed Brick Autosaver");
+}
+void DapperCraft::details::BrickAutosaver::autosave(BrickSnapshot snapshot) {
+        {
+                std::lock_guard lock(m_mutex);
+                // A displaced snapshot may be the last owner of pages edited since, so the worker releases it instead
+                if (m_pending_snapshot.has_value())
+                        m_released_snapshots.emplace_back(std::move(*m_pending_snapshot));
+                m_pending_snapshot = std::move(snapshot);
+        }
+        m_condition.notify_one();
+}
+bool DapperCraft::details::BrickAutosaver::load(std::string_view save_path, BrickStorage &storage) {
+        TRACE("Loading Brick Save: %s...", save_path.data());
+        std::string path(save_path);
+        if (!std::filesystem::exists(path)) {
+                ERROR("\t⎿ Brick Save Not Found: %s", path.c_str());
+                return false;
+        }
+        auto bytes = readSaveFile(path);
+        // Validate the whole save first, so a corrupt save never leaves the storage partially restored
+        auto scan = scanRecords(bytes, [](uint32_t, const std::vector<SavedBrick>&) {});
+        if (scan.status == RecordStatus::eCorrupt) {
+                ERROR("\t⎿ Corrupt Brick Save at Offset %zu: %s", scan.valid_size, path.c_str());
+                return false;
+        }
+        if (scan.record_count != 0 && scan.brick_count != storage.brickCount()) {
+                ERROR("\t⎿ Brick Save Has %u Bricks, Storage Has %u", scan.brick_count, storage.brickCount());
+                return false;
+        }
+        if (scan.status == RecordStatus::eTruncated)
+                WARN("\t⎿ Ignoring Incomplete Trailing Record at Offset %zu", scan.valid_size);
+
+        scanRecords(bytes, [&storage](uint32_t, const std::vector<SavedBrick> &bricks) {
+                for (const auto &saved_brick: bricks)
+                        storage.restoreBrick(saved_brick.index, saved_brick.brick, saved_brick.version);
+        });
+        TRACE("Loaded Brick Save: %u Records, Version %llu", scan.record_count, static_cast<unsigned long long>(storage.version()));
+        return true;
+}
+void DapperCraft::details::BrickAutosaver::run() {
+        while (true) {
+                std::optional<BrickSnapshot> snapshot;
+                std::vector<BrickSnapshot> released_snapshots;
+                bool stopping = false;
+                {
+                        std::unique_lock lock(m_mutex);
+                        m_condition.wait(lock, [this] { return m_stopping || m_pending_snapshot.has_value(); });
+                        snapshot.swap(m_pending_snapshot);
+                        released_snapshots.swap(m_released_snapshots);
+                        stopping = m_stopping;
+                }
+                released_snapshots.clear();
+
+                // The previous snapshot is released here, so pages it alone kept alive are freed off the main thread
+                if (snapshot.has_value() && snapshot->version() != m_saved_snapshot.version()) {
+                        bool saved = m_record_count >= m_max_records ? compact(*snapshot) || write(*snapshot) : write(*snapshot);
+                        if (saved)
+                                m_saved_snapshot = std::move(*snapshot);
+                }
+                if (stopping)
+                        return;
+        }
+}
+bool DapperCraft::details::BrickAutosaver::write(const BrickSnapshot &snapshot) {
+        if (m_saved_brick_count != 0 && snapshot.brickCount() != m_saved_brick_count) {
+                ERROR("Autosave Has %u Bricks, Snapshot Has %u", m_saved_brick_count, snapshot.brickCount());
+                return false;
+        }
+        uint32_t changed_count = 0;
+        auto record = buildRecord(snapshot, m_saved_snapshot, changed_count);
+
+        // The record goes out in one write; on failure the file is cut back to the last complete record
+        std::ofstream file(m_save_path, std::ios::binary | std::ios::app);
+        file.write(record.data(), static_cast<std::streamsize>(record.size()));
+        file.flush();
+        if (!file) {
+                file.close();
+                std::error_code error;
+                std::filesystem::resize_file(m_save_path, m_saved_size, error);
+                ERROR("Failed to Write Autosave: %s", m_save_path.c_str());
+                return false;
+        }
+        m_saved_size += record.size();
+        m_saved_brick_count = snapshot.brickCount();
+        m_record_count++;
+        TRACE("Autosaved Version %llu: %u Changed Bricks", static_cast<unsigned long long>(snapshot.version()), changed_count);
+        return true;
+}
+bool DapperCraft::details::BrickAutosaver::compact(const BrickSnapshot &snapshot) {
+        if (m_saved_brick_count != 0 && snapshot.brickCount() != m_saved_brick_count) {
+                ERROR("Autosave Has %u Bricks, Snapshot Has %u", m_saved_brick_count, snapshot.brickCount());
+                return false;
+        }
+        uint32_t changed_count = 0;
+        auto record = buildRecord(snapshot, BrickSnapshot{}, changed_count);
+
+        // Written beside the save and renamed over it, so a crash mid-compaction keeps the old save intact
+        std::string temporary_path = m_save_path + ".tmp";
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(record.data(), static_cast<std::streamsize>(record.size()));
+        file.flush();
+        bool written = static_cast<bool>(file);
+        file.close();
+        std::error_code error;
+        if (written)
+                std::filesystem::rename(temporary_path, m_save_path, error);
+        if (!written || error) {
+                std::filesystem::remove(temporary_path, error);
+                ERROR("Failed to Compact Autosave: %s", m_save_path.c_str());
+                return false;
+        }
+        m_saved_size = record.size();
+        m_saved_brick_count = snapshot.brickCount();
+        m_record_count = 1;
+        TRACE("Compacted Autosave to Version %llu: %u Bricks", static_cast<unsigned long long>(snapshot.version()), changed_count);
+        return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "brick_storage.h"
+
+
+namespace DapperCraft::details {
+        constexpr uint32_t default_autosave_max_records = 64;
+
+        // Writes snapshots on a background thread, appending only the bricks changed since the previous save.
+        // autosave() only hands over the snapshot, so the main thread cost is independent of world size.
+        // Once the save holds max_records records the worker rewrites it as one full record (temp file, then rename),
+        // so file size, load() and the constructor's validation scale with the edited bricks rather than session length.
+        class BrickAutosaver {
+        public: // Public constructors/destructors/overloads
+                // An existing save is validated and appended to; saved_snapshot is the state already on disk (e.g. right after load())
+                explicit BrickAutosaver(std::string_view save_path, BrickSnapshot saved_snapshot = {}, uint32_t max_records = default_autosave_max_records);
+                ~BrickAutosaver();
+
+        public: // Public methods
+                void autosave(BrickSnapshot snapshot);
+                static bool load(std::string_view save_path, BrickStorage &storage);
+
+        public: // Public members
+
+        private: // Private methods
+                void run();
+                bool write(const BrickSnapshot &snapshot);
+                bool compact(const BrickSnapshot &snapshot);
+
+        private: // Private members
+                std::string m_save_path;
+                uint64_t m_saved_size{0};
+                uint32_t m_saved_brick_count{0};
+                uint32_t m_record_count{0};
+                uint32_t m_max_records{default_autosave_max_records};
+                std::mutex m_mutex;
+                std::condition_variable m_condition;
+                std::optional<BrickSnapshot> m_pending_snapshot{};
+                std::vector<BrickSnapshot> m_released_snapshots{};
+                bool m_stopping{false};
+                BrickSnapshot m_saved_snapshot{};
+                std::thread m_thread;
+        };
+
+        void appendEncodedBrick(std::vector<char> &buffer, const Brick &brick);
+        bool readEncodedBrick(const char* &data, const char* end, Brick &brick);
+}
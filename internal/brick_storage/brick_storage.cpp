@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <atomic>
+#include "brick_storage.h"
+#include "logger/logger.h"
+
+// Directory helper functions
+const DapperCraft::details::BrickPageTable& findTable(const DapperCraft::details::BrickDirectory &directory, uint32_t table_index) {
+        const auto &group = directory.groups[table_index / DapperCraft::details::tables_per_group];
+        return *group->tables[table_index % DapperCraft::details::tables_per_group];
+}
+const DapperCraft::details::BrickPage& findPage(const DapperCraft::details::BrickDirectory &directory, uint32_t index) {
+        const auto &table = findTable(directory, index / DapperCraft::details::bricks_per_table);
+        return *table.pages[(index / DapperCraft::details::bricks_per_page) % DapperCraft::details::pages_per_table];
+}
+// Other threads only reach storage through snapshots, so an object uniquely owned by the storage can never gain a reference.
+// The fence orders the in-place write after the release of whichever snapshot dropped the last other reference.
+template<typename T>
+void makeUnique(std::shared_ptr<T> &shared) {
+        if (shared.use_count() > 1)
+                shared = std::make_shared<T>(*shared);
+        else
+                std::atomic_thread_fence(std::memory_order_acquire);
+}
+// Shared by every storage, so untouched regions of any world compare equal by pointer to those of an empty world
+const std::shared_ptr<DapperCraft::details::BrickTableGroup>& emptyGroup() {
+        static const auto empty_group = [] {
+                auto empty_table = std::make_shared<DapperCraft::details::BrickPageTable>();
+                empty_table->pages.fill(std::make_shared<DapperCraft::details::BrickPage>());
+                auto group = std::make_shared<DapperCraft::details::BrickTableGroup>();
+                group->tables.fill(empty_table);
+                return group;
+        }();
+        return empty_group;
+}
+
+
+const DapperCraft::details::Brick& DapperCraft::details::BrickSnapshot::brick(uint32_t index) const {
+        SILENT_ASSERT((index < m_brick_count), FATAL("Brick Index Out of Range: %u", index))
+        return findPage(*m_directory, index).bricks[index % bricks_per_page];
+}
+uint64_t DapperCraft::details::BrickSnapshot::brickVersion(uint32_t index) const {
+        SILENT_ASSERT((index < m_brick_count), FATAL("Brick Index Out of Range: %u", index))
+        return findPage(*m_directory, index).versions[index % bricks_per_page];
+}
+uint32_t DapperCraft::details::BrickSnapshot::brickCount() const {
+        return m_brick_count;
+}
+uint64_t DapperCraft::details::BrickSnapshot::version() const {
+        return m_version;
+}
+const DapperCraft::details::BrickPage* DapperCraft::details::BrickSnapshot::page(uint32_t page_index) const {
+        return findTable(*m_directory, page_index / pages_per_table).pages[page_index % pages_per_table].get();
+}
+const DapperCraft::details::BrickPageTable* DapperCraft::details::BrickSnapshot::table(uint32_t table_index) const {
+        return &findTable(*m_directory, table_index);
+}
+const DapperCraft::details::BrickTableGroup* DapperCraft::details::BrickSnapshot::group(uint32_t group_index) const {
+        return m_directory->groups[group_index].get();
+}
+
+
+DapperCraft::details::BrickStorage::BrickStorage(uint32_t brick_count) : m_brick_count(brick_count) {
+        TRACE("Initializing Brick Storage...");
+        // Every page, table and group starts out shared, so an empty world costs only its root until edited
+        m_directory = std::make_shared<BrickDirectory>();
+        m_directory->groups.resize((static_cast<uint64_t>(brick_count) + bricks_per_group - 1) / bricks_per_group, emptyGroup());
+        TRACE("Initialized Brick Storage: %u Bricks, %zu Table Groups", brick_count, m_directory->groups.size());
+}
+const DapperCraft::details::Brick& DapperCraft::details::BrickStorage::brick(uint32_t index) const {
+        SILENT_ASSERT((index < m_brick_count), FATAL("Brick Index Out of Range: %u", index))
+        return findPage(*m_directory, index).bricks[index % bricks_per_page];
+}
+uint64_t DapperCraft::details::BrickStorage::brickVersion(uint32_t index) const {
+        SILENT_ASSERT((index < m_brick_count), FATAL("Brick Index Out of Range: %u", index))
+        return findPage(*m_directory, index).versions[index % bricks_per_page];
+}
+uint32_t DapperCraft::details::BrickStorage::brickCount() const {
+        return m_brick_count;
+}
+uint64_t DapperCraft::details::BrickStorage::version() const {
+        return m_version;
+}
+void DapperCraft::details::BrickStorage::setBrick(uint32_t index, const Brick &brick) {
+        SILENT_ASSERT((index < m_brick_count), FATAL("Brick Index Out of Range: %u", index))
+        BrickPage &page = writablePage(index);
+        page.bricks[index % bricks_per_page] = brick;
+        page.versions[index % bricks_per_page] = ++m_version;
+}
+void DapperCraft::details::BrickStorage::restoreBrick(uint32_t index, const Brick &brick, uint64_t version) {
+        SILENT_ASSERT((index < m_brick_count), FATAL("Brick Index Out of Range: %u", index))
+        BrickPage &page = writablePage(index);
+        page.bricks[index % bricks_per_page] = brick;
+        page.versions[index % bricks_per_page] = version;
+        m_version = std::max(m_version, version);
+}
+DapperCraft::details::BrickSnapshot DapperCraft::details::BrickStorage::snapshot() const {
+        BrickSnapshot snapshot;
+        snapshot.m_directory = m_directory;
+        snapshot.m_brick_count = m_brick_count;
+        snapshot.m_version = m_version;
+        return snapshot;
+}
+DapperCraft::details::BrickPage& DapperCraft::details::BrickStorage::writablePage(uint32_t index) {
+        makeUnique(m_directory);
+        auto &group = m_directory->groups[index / bricks_per_group];
+        makeUnique(group);
+        auto &table = group->tables[(index / bricks_per_table) % tables_per_group];
+        makeUnique(table);
+        auto &page = table->pages[(index / bricks_per_page) % pages_per_table];
+        makeUnique(page);
+        return *page;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace DapperCraft::details {
+        constexpr uint32_t brick_dimension = 8;
+        constexpr uint32_t bricks_per_page = 64;
+        constexpr uint32_t pages_per_table = 256;
+        constexpr uint32_t tables_per_group = 256;
+        constexpr uint32_t bricks_per_table = bricks_per_page * pages_per_table;
+        constexpr uint32_t bricks_per_group = bricks_per_table * tables_per_group;
+
+        struct Brick {
+                std::array<uint8_t, brick_dimension * brick_dimension * brick_dimension> voxels{};
+        };
+        struct BrickPage {
+                std::array<Brick, bricks_per_page> bricks{};
+                std::array<uint64_t, bricks_per_page> versions{};
+        };
+        struct BrickPageTable {
+                std::array<std::shared_ptr<BrickPage>, pages_per_table> pages{};
+        };
+        struct BrickTableGroup {
+                std::array<std::shared_ptr<BrickPageTable>, tables_per_group> tables{};
+        };
+        // The full 32-bit brick index range needs at most 1024 groups, so the root never grows past that
+        struct BrickDirectory {
+                std::vector<std::shared_ptr<BrickTableGroup>> groups{};
+        };
+
+        // Immutable view of the storage at one point in time, safe to read from any thread
+        class BrickSnapshot {
+        public: // Public constructors/destructors/overloads
+                BrickSnapshot() = default;
+
+        public: // Public methods
+                [[nodiscard]] const Brick& brick(uint32_t index) const;
+                [[nodiscard]] uint64_t brickVersion(uint32_t index) const;
+                [[nodiscard]] uint32_t brickCount() const;
+                [[nodiscard]] uint64_t version() const;
+                [[nodiscard]] const BrickPage* page(uint32_t page_index) const;
+                [[nodiscard]] const BrickPageTable* table(uint32_t table_index) const;
+                [[nodiscard]] const BrickTableGroup* group(uint32_t group_index) const;
+
+        public: // Public members
+
+        private: // Private methods
+                friend class BrickStorage;
+
+        private: // Private members
+                std::shared_ptr<const BrickDirectory> m_directory{};
+                uint32_t m_brick_count{0};
+                uint64_t m_version{0};
+        };
+
+        // Paged brick storage with copy-on-write snapshots.
+        // Every level is shared with snapshots until the owning thread next edits it, so taking a snapshot is O(1).
+        // The first edit under a snapshot copies the root (at most 1024 pointers), one group, one table and one page,
+        // which bounds the main-thread cost for any world that fits a 32-bit brick index.
+        class BrickStorage {
+        public: // Public constructors/destructors/overloads
+                explicit BrickStorage(uint32_t brick_count);
+
+        public: // Public methods
+                [[nodiscard]] const Brick& brick(uint32_t index) const;
+                [[nodiscard]] uint64_t brickVersion(uint32_t index) const;
+                [[nodiscard]] uint32_t brickCount() const;
+                [[nodiscard]] uint64_t version() const;
+                void setBrick(uint32_t index, const Brick &brick);
+                // Writes a brick at a previously saved version, used when replaying a save
+                void restoreBrick(uint32_t index, const Brick &brick, uint64_t version);
+                [[nodiscard]] BrickSnapshot snapshot() const;
+
+        public: // Public members
+
+        private: // Private methods
+                BrickPage& writablePage(uint32_t index);
+
+        private: // Private members
+                std::shared_ptr<BrickDirectory> m_directory{};
+                uint32_t m_brick_count{0};
+                uint64_t m_version{0};
+        };
+}
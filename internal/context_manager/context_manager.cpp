@@ -1,7 +1,8 @@
+#include <chrono>
 #include "context_manager.h"
 #include "logger/logger.h"
 
-DapperCraft::EngineContext::EngineContext(std::string_view window_title, glm::ivec2 window_dimensions) {
+DapperCraft::EngineContext::EngineContext(std::string_view window_title, glm::ivec2 window_dimensions, bool hidden) : m_window_dimensions(window_dimensions) {
         TRACE("Initializing Engine Context...");
         
         TRACE("\t⎿ Initializing GLFW...");
@@ -9,6 +10,8 @@ DapperCraft::EngineContext::EngineContext(std::string_view window_title, glm::iv
         
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
         glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+        if (hidden)
+                glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
         TRACE("\t⎿ Initialized GLFW");
         
         
@@ -37,15 +40,60 @@ DapperCraft::EngineContext::~EngineContext() {
 void DapperCraft::EngineContext::draw() {
 
 }
-bool DapperCraft::EngineContext::update() {
+bool DapperCraft::EngineContext::update([[maybe_unused]] float delta_time) {
         glfwPollEvents();
         return true;
 }
 void DapperCraft::EngineContext::run() {
         TRACE("Starting Engine Run Loop...");
+        double previous_time = glfwGetTime();
         while (!glfwWindowShouldClose(m_window)) {
-                update();
+                double current_time = glfwGetTime();
+                update(static_cast<float>(current_time - previous_time));
+                previous_time = current_time;
                 draw();
         }
         TRACE("Ending Engine Run Loop...");
 }
+void DapperCraft::EngineContext::runRecording(std::string_view recording_path, float timestep) {
+        TRACE("Starting Engine Recording Loop...");
+        details::SceneRecording recording(m_window_dimensions, timestep);
+        double previous_time = glfwGetTime();
+        double accumulated_time = 0.0;
+        while (!glfwWindowShouldClose(m_window)) {
+                double current_time = glfwGetTime();
+                update(static_cast<float>(current_time - previous_time));
+                accumulated_time += current_time - previous_time;
+                previous_time = current_time;
+                
+                // Sample once per elapsed timestep so the frame count depends on wall-clock time, not on loop speed
+                for (; accumulated_time >= timestep; accumulated_time -= timestep)
+                        recording.record({.camera = m_camera});
+                draw();
+        }
+        TRACE("Ending Engine Recording Loop...");
+        recording.save(recording_path);
+}
+DapperCraft::details::FrameStatistics DapperCraft::EngineContext::runReplay(const details::SceneRecording &recording) {
+        TRACE("Starting Engine Replay Loop...");
+        std::vector<double> frame_times_ms;
+        frame_times_ms.reserve(recording.frames().size());
+        
+        // Every recorded frame is stepped by the recording's timestep, back-to-back, so runs are independent of wall-clock pacing
+        for (int i = 0; const auto &frame: recording.frames()) {
+                if (glfwWindowShouldClose(m_window)) {
+                        WARN("Replay Closed Early After %d of %zu Frames", i, recording.frames().size());
+                        break;
+                }
+                auto frame_start = std::chrono::steady_clock::now();
+                update(recording.timestep());
+                m_camera = frame.camera;
+                draw();
+                auto frame_end = std::chrono::steady_clock::now();
+                
+                frame_times_ms.emplace_back(std::chrono::duration<double, std::milli>(frame_end - frame_start).count());
+                DEBUG("Frame #%d: %.3f ms (CPU)", i++, frame_times_ms.back());
+        }
+        TRACE("Ending Engine Replay Loop...");
+        return details::computeFrameStatistics(std::move(frame_times_ms));
+}
\ No newline at end of file
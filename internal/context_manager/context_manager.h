@@ -2,22 +2,28 @@
 #include <glm/glm.hpp>
 #include <string_view>
 #include "render_engine.h"
+#include "frame_recorder.h"
 
 namespace DapperCraft {
         class EngineContext {
         public: // Public constructors/destructors/overloads
-                EngineContext(std::string_view window_title, glm::ivec2 window_dimensions);
+                EngineContext(std::string_view window_title, glm::ivec2 window_dimensions, bool hidden = false);
                 ~EngineContext();
         public: // Public methods
                 void draw();
-                bool update();
+                bool update(float delta_time);
                 void run();
+                void runRecording(std::string_view recording_path, float timestep = details::default_recording_timestep);
+                details::FrameStatistics runReplay(const details::SceneRecording &recording);
         public: // Public members
         
         private: // Private methods
         
         private: // Private members
                 GLFWwindow* m_window{nullptr};
+                glm::ivec2 m_window_dimensions{};
+                // Nothing drives the camera yet; recordings capture it and replays restore it for when input lands
+                details::CameraState m_camera{};
                 details::RenderEngine m_render_engine;
         };
 }
\ No newline at end of file
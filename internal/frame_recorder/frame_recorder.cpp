@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include "frame_recorder.h"
+#include "logger/logger.h"
+
+// File layout: magic, version, window dimensions, timestep, frame count, then tightly packed frames
+constexpr char recording_magic[4] = {'B', 'C', 'R', 'C'};
+constexpr uint32_t recording_version = 2;
+
+DapperCraft::details::SceneRecording::SceneRecording(glm::ivec2 window_dimensions, float timestep) : m_window_dimensions(window_dimensions), m_timestep(timestep) {}
+
+void DapperCraft::details::SceneRecording::record(const FrameRecord &frame) {
+        m_frames.emplace_back(frame);
+}
+void DapperCraft::details::SceneRecording::save(std::string_view path) const {
+        TRACE("Saving Scene Recording: %s...", path.data());
+        std::ofstream file(std::string(path), std::ios::binary);
+        if (!file)
+                FATAL("\t⎿ Failed to Open Scene Recording: %s", path.data());
+
+        uint64_t frame_count = m_frames.size();
+        file.write(recording_magic, sizeof(recording_magic));
+        file.write(reinterpret_cast<const char*>(&recording_version), sizeof(recording_version));
+        file.write(reinterpret_cast<const char*>(&m_window_dimensions), sizeof(m_window_dimensions));
+        file.write(reinterpret_cast<const char*>(&m_timestep), sizeof(m_timestep));
+        file.write(reinterpret_cast<const char*>(&frame_count), sizeof(frame_count));
+        file.write(reinterpret_cast<const char*>(m_frames.data()), static_cast<std::streamsize>(frame_count * sizeof(FrameRecord)));
+
+        if (!file)
+                FATAL("\t⎿ Failed to Write Scene Recording: %s", path.data());
+        TRACE("Saved Scene Recording: %llu Frames", static_cast<unsigned long long>(frame_count));
+}
+DapperCraft::details::SceneRecording DapperCraft::details::SceneRecording::load(std::string_view path) {
+        TRACE("Loading Scene Recording: %s...", path.data());
+        std::ifstream file(std::string(path), std::ios::binary | std::ios::ate);
+        if (!file)
+                FATAL("\t⎿ Failed to Open Scene Recording: %s", path.data());
+        auto file_size = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        char magic[4];
+        uint32_t version = 0;
+        uint64_t frame_count = 0;
+        SceneRecording recording;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (!file || memcmp(magic, recording_magic, sizeof(magic)) != 0 || version != recording_version)
+                FATAL("\t⎿ Invalid Scene Recording: %s", path.data());
+
+        file.read(reinterpret_cast<char*>(&recording.m_window_dimensions), sizeof(recording.m_window_dimensions));
+        file.read(reinterpret_cast<char*>(&recording.m_timestep), sizeof(recording.m_timestep));
+        file.read(reinterpret_cast<char*>(&frame_count), sizeof(frame_count));
+        // Check the frame count against the file size before allocating, so a corrupt header cannot request gigabytes
+        auto remaining_size = file ? file_size - static_cast<uint64_t>(file.tellg()) : 0;
+        if (!file || frame_count > remaining_size / sizeof(FrameRecord))
+                FATAL("\t⎿ Truncated Scene Recording: %s", path.data());
+        if (!(recording.m_timestep > 0.0f))
+                FATAL("\t⎿ Invalid Timestep in Scene Recording: %s", path.data());
+        recording.m_frames.resize(frame_count);
+        file.read(reinterpret_cast<char*>(recording.m_frames.data()), static_cast<std::streamsize>(frame_count * sizeof(FrameRecord)));
+        if (!file)
+                FATAL("\t⎿ Truncated Scene Recording: %s", path.data());
+
+        TRACE("Loaded Scene Recording: %llu Frames", static_cast<unsigned long long>(frame_count));
+        return recording;
+}
+glm::ivec2 DapperCraft::details::SceneRecording::windowDimensions() const {
+        return m_window_dimensions;
+}
+float DapperCraft::details::SceneRecording::timestep() const {
+        return m_timestep;
+}
+const std::vector<DapperCraft::details::FrameRecord>& DapperCraft::details::SceneRecording::frames() const {
+        return m_frames;
+}
+
+
+// Statistics/baseline helper functions
+DapperCraft::details::FrameStatistics DapperCraft::details::computeFrameStatistics(std::vector<double> frame_times_ms) {
+        FrameStatistics statistics;
+        if (frame_times_ms.empty())
+                return statistics;
+
+        std::sort(frame_times_ms.begin(), frame_times_ms.end());
+        statistics.frame_count = frame_times_ms.size();
+        statistics.mean_ms = std::accumulate(frame_times_ms.begin(), frame_times_ms.end(), 0.0) / static_cast<double>(frame_times_ms.size());
+        statistics.median_ms = frame_times_ms[frame_times_ms.size() / 2];
+        statistics.p99_ms = frame_times_ms[(frame_times_ms.size() - 1) * 99 / 100];
+        statistics.min_ms = frame_times_ms.front();
+        statistics.max_ms = frame_times_ms.back();
+        return statistics;
+}
+void DapperCraft::details::logFrameStatistics(const FrameStatistics &statistics) {
+        INFO("Frame Statistics (%llu Frames):", static_cast<unsigned long long>(statistics.frame_count));
+        INFO("\t⎿ Mean:   %.3f ms", statistics.mean_ms);
+        INFO("\t⎿ Median: %.3f ms", statistics.median_ms);
+        INFO("\t⎿ P99:    %.3f ms", statistics.p99_ms);
+        INFO("\t⎿ Min:    %.3f ms", statistics.min_ms);
+        INFO("\t⎿ Max:    %.3f ms", statistics.max_ms);
+}
+void DapperCraft::details::saveBaseline(std::string_view path, const FrameStatistics &statistics) {
+        std::ofstream file{std::string(path)};
+        if (!file)
+                FATAL("Failed to Open Baseline: %s", path.data());
+        file << statistics.frame_count << " " << statistics.mean_ms << " " << statistics.median_ms << " "
+             << statistics.p99_ms << " " << statistics.min_ms << " " << statistics.max_ms << "\n";
+        TRACE("Saved Baseline: %s", path.data());
+}
+DapperCraft::details::FrameStatistics DapperCraft::details::loadBaseline(std::string_view path) {
+        std::ifstream file{std::string(path)};
+        FrameStatistics statistics;
+        file >> statistics.frame_count >> statistics.mean_ms >> statistics.median_ms
+             >> statistics.p99_ms >> statistics.min_ms >> statistics.max_ms;
+        if (!file)
+                FATAL("Failed to Read Baseline: %s", path.data());
+        return statistics;
+}
+bool DapperCraft::details::withinBaseline(const FrameStatistics &statistics, const FrameStatistics &baseline, double threshold_percent) {
+        if (statistics.frame_count != baseline.frame_count) {
+                ERROR("Baseline Frame Count Mismatch: %llu Frames vs %llu Baseline Frames", static_cast<unsigned long long>(statistics.frame_count), static_cast<unsigned long long>(baseline.frame_count));
+                return false;
+        }
+        const double limit = 1.0 + threshold_percent / 100.0;
+        bool within = true;
+        if (statistics.mean_ms > baseline.mean_ms * limit) {
+                ERROR("Mean Frame Time Regressed: %.3f ms -> %.3f ms", baseline.mean_ms, statistics.mean_ms);
+                within = false;
+        }
+        if (statistics.p99_ms > baseline.p99_ms * limit) {
+                ERROR("P99 Frame Time Regressed: %.3f ms -> %.3f ms", baseline.p99_ms, statistics.p99_ms);
+                within = false;
+        }
+        if (within)
+                INFO("Frame Times Within %.1f%% of Baseline", threshold_percent);
+        return within;
+}
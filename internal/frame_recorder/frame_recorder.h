@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <glm/glm.hpp>
+
+
+namespace DapperCraft::details {
+        constexpr float default_recording_timestep = 1.0f / 60.0f;
+
+        struct CameraState {
+                glm::vec3 position{0.0f, 0.0f, 0.0f};
+                glm::vec3 direction{0.0f, 0.0f, -1.0f};
+        };
+        // Only the camera is captured per frame; world edits are not recorded, and window dimensions are the only setting (in the header)
+        struct FrameRecord {
+                CameraState camera;
+        };
+        struct FrameStatistics {
+                uint64_t frame_count{0};
+                double mean_ms{0.0};
+                double median_ms{0.0};
+                double p99_ms{0.0};
+                double min_ms{0.0};
+                double max_ms{0.0};
+        };
+
+        // Binary capture of a run sampled once per fixed timestep, replayed one recorded frame per replayed frame
+        class SceneRecording {
+        public: // Public constructors/destructors/overloads
+                SceneRecording() = default;
+                SceneRecording(glm::ivec2 window_dimensions, float timestep);
+
+        public: // Public methods
+                void record(const FrameRecord &frame);
+                void save(std::string_view path) const;
+                static SceneRecording load(std::string_view path);
+
+                [[nodiscard]] glm::ivec2 windowDimensions() const;
+                [[nodiscard]] float timestep() const;
+                [[nodiscard]] const std::vector<FrameRecord>& frames() const;
+
+        public: // Public members
+
+        private: // Private methods
+
+        private: // Private members
+                glm::ivec2 m_window_dimensions{};
+                float m_timestep{default_recording_timestep};
+                std::vector<FrameRecord> m_frames{};
+        };
+
+        FrameStatistics computeFrameStatistics(std::vector<double> frame_times_ms);
+        void logFrameStatistics(const FrameStatistics &statistics);
+        void saveBaseline(std::string_view path, const FrameStatistics &statistics);
+        FrameStatistics loadBaseline(std::string_view path);
+        bool withinBaseline(const FrameStatistics &statistics, const FrameStatistics &baseline, double threshold_percent);
+}
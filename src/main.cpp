@@ -1,8 +1,70 @@
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
 #include "context_manager.h"
+#include "logger/logger.h"
 
+// Usage:
+//      BrickCraft --record output/<name>.bcr
+//      BrickCraft --replay output/<name>.bcr [--hidden] [--baseline <file>] [--threshold <percent>] [--write-baseline <file>]
+// --hidden only hides the replay window; a display and a Vulkan surface are still required
 int main(int argc, char *argv[]) {
-        DapperCraft::EngineContext engine_context("test", {800, 800});
-        engine_context.run();
+        std::string_view record_path;
+        std::string_view replay_path;
+        std::string_view baseline_path;
+        std::string_view write_baseline_path;
+        double threshold_percent = 5.0;
+        bool hidden = false;
+
+        for (int i = 1; i < argc; i++) {
+                bool has_value = i + 1 < argc;
+                if (strcmp(argv[i], "--record") == 0 && has_value)
+                        record_path = argv[++i];
+                else if (strcmp(argv[i], "--replay") == 0 && has_value)
+                        replay_path = argv[++i];
+                else if (strcmp(argv[i], "--baseline") == 0 && has_value)
+                        baseline_path = argv[++i];
+                else if (strcmp(argv[i], "--write-baseline") == 0 && has_value)
+                        write_baseline_path = argv[++i];
+                else if (strcmp(argv[i], "--threshold") == 0 && has_value) {
+                        char* end = nullptr;
+                        threshold_percent = std::strtod(argv[++i], &end);
+                        if (end == argv[i] || *end != '\0' || !(threshold_percent >= 0.0))
+                                FATAL("Invalid Threshold: %s", argv[i]);
+                }
+                else if (strcmp(argv[i], "--hidden") == 0)
+                        hidden = true;
+                else
+                        FATAL("Unknown Argument: %s", argv[i]);
+        }
+        if (!record_path.empty() && !replay_path.empty())
+                FATAL("--record and --replay Cannot Be Combined");
+        if (replay_path.empty() && (!baseline_path.empty() || !write_baseline_path.empty()))
+                FATAL("--baseline and --write-baseline Require --replay");
+        if (replay_path.empty() && hidden)
+                FATAL("--hidden Requires --replay");
+
+        if (replay_path.empty()) {
+                DapperCraft::EngineContext engine_context("test", {800, 800});
+                if (record_path.empty())
+                        engine_context.run();
+                else
+                        engine_context.runRecording(record_path);
+                return 0;
+        }
+
+        auto recording = DapperCraft::details::SceneRecording::load(replay_path);
+        DapperCraft::details::FrameStatistics statistics;
+        {
+                DapperCraft::EngineContext engine_context("test", recording.windowDimensions(), hidden);
+                statistics = engine_context.runReplay(recording);
+        }
+        DapperCraft::details::logFrameStatistics(statistics);
+
+        if (!write_baseline_path.empty())
+                DapperCraft::details::saveBaseline(write_baseline_path, statistics);
+        if (!baseline_path.empty() && !DapperCraft::details::withinBaseline(statistics, DapperCraft::details::loadBaseline(baseline_path), threshold_percent))
+                return EXIT_FAILURE;
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,165 @@
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "brick_autosaver.h"
+#include "logger/logger.h"
+
+// Edits, autosaves, reloads and checks every brick and version survives, including appends after a restart,
+// a trailing record cut short by a crash, corruption mid-file, compaction and a world at the 32-bit index limit.
+// See README.md for the build command.
+constexpr uint32_t round_trip_seed = 1337;
+constexpr uint32_t round_trip_brick_count = 100'000;
+
+void editBricks(DapperCraft::details::BrickStorage &storage, std::mt19937 &rng, uint32_t edit_count) {
+        std::uniform_int_distribution<uint32_t> index_distribution(0, storage.brickCount() - 1);
+        std::uniform_int_distribution<uint32_t> voxel_distribution(0, 3);
+        for (uint32_t i = 0; i < edit_count; i++) {
+                DapperCraft::details::Brick brick;
+                for (auto &voxel: brick.voxels)
+                        voxel = static_cast<uint8_t>(voxel_distribution(rng));
+                storage.setBrick(index_distribution(rng), brick);
+        }
+}
+bool matches(const DapperCraft::details::BrickStorage &expected, const DapperCraft::details::BrickStorage &actual) {
+        if (expected.version() != actual.version()) {
+                ERROR("Version Mismatch: %llu vs %llu", static_cast<unsigned long long>(expected.version()), static_cast<unsigned long long>(actual.version()));
+                return false;
+        }
+        for (uint32_t i = 0; i < expected.brickCount(); i++) {
+                if (expected.brickVersion(i) != actual.brickVersion(i) || expected.brick(i).voxels != actual.brick(i).voxels) {
+                        ERROR("Brick #%u Mismatch", i);
+                        return false;
+                }
+        }
+        return true;
+}
+bool loadsAs(const std::string &save_path, const DapperCraft::details::BrickStorage &expected) {
+        DapperCraft::details::BrickStorage loaded(expected.brickCount());
+        return DapperCraft::details::BrickAutosaver::load(save_path, loaded) && matches(expected, loaded);
+}
+// One autosaver lifetime per call, so each call appends exactly one record (or compacts)
+void saveSession(const std::string &save_path, DapperCraft::details::BrickStorage &storage, std::mt19937 &rng, uint32_t max_records = DapperCraft::details::default_autosave_max_records) {
+        DapperCraft::details::BrickAutosaver autosaver(save_path, storage.snapshot(), max_records);
+        editBricks(storage, rng, 100);
+        autosaver.autosave(storage.snapshot());
+}
+std::vector<char> readFile(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+uint64_t recordSize(const std::vector<char> &bytes, size_t offset) {
+        uint64_t record_size = 0;
+        std::memcpy(&record_size, bytes.data() + offset + 4, sizeof(record_size));
+        return record_size;
+}
+
+int main() {
+        std::string save_path = (std::filesystem::temp_directory_path() / "brickcraft_round_trip.bcws").string();
+        std::filesystem::remove(save_path);
+        std::mt19937 rng(round_trip_seed);
+
+        DapperCraft::details::BrickStorage storage(round_trip_brick_count);
+        {
+                DapperCraft::details::BrickAutosaver autosaver(save_path);
+                editBricks(storage, rng, 1'000);
+                autosaver.autosave(storage.snapshot());
+                editBricks(storage, rng, 1'000);
+                autosaver.autosave(storage.snapshot());
+        }
+        if (!loadsAs(save_path, storage))
+                return EXIT_FAILURE;
+
+        // Restarting must append to the existing save rather than replace it
+        DapperCraft::details::BrickStorage restored(round_trip_brick_count);
+        DapperCraft::details::BrickAutosaver::load(save_path, restored);
+        {
+                DapperCraft::details::BrickAutosaver autosaver(save_path, restored.snapshot());
+                editBricks(restored, rng, 1'000);
+                autosaver.autosave(restored.snapshot());
+        }
+        if (!loadsAs(save_path, restored))
+                return EXIT_FAILURE;
+
+        // A record cut short by a crash is ignored on load and dropped before the next append
+        {
+                std::ofstream file(save_path, std::ios::binary | std::ios::app);
+                file.write("BCWS\x01\x02\x03", 7);
+        }
+        if (!loadsAs(save_path, restored))
+                return EXIT_FAILURE;
+        {
+                DapperCraft::details::BrickAutosaver autosaver(save_path, restored.snapshot());
+                editBricks(restored, rng, 10);
+                autosaver.autosave(restored.snapshot());
+        }
+        if (!loadsAs(save_path, restored))
+                return EXIT_FAILURE;
+
+        // Corruption inside a middle record is rejected by load() and the constructor, and the file is left untouched
+        std::filesystem::remove(save_path);
+        DapperCraft::details::BrickStorage corrupted(round_trip_brick_count);
+        for (int i = 0; i < 3; i++)
+                saveSession(save_path, corrupted, rng);
+        auto bytes = readFile(save_path);
+        size_t second_record = recordSize(bytes, 0);
+        bytes[second_record + recordSize(bytes, second_record) / 2] ^= 0x5A;
+        {
+                std::ofstream file(save_path, std::ios::binary | std::ios::trunc);
+                file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        DapperCraft::details::BrickStorage rejected(round_trip_brick_count);
+        if (DapperCraft::details::BrickAutosaver::load(save_path, rejected) || rejected.version() != 0) {
+                ERROR("Corrupt Save Was Loaded");
+                return EXIT_FAILURE;
+        }
+        std::cout.flush();
+        pid_t child = fork();
+        if (child == 0) {
+                DapperCraft::details::BrickAutosaver autosaver(save_path);
+                _exit(EXIT_SUCCESS);
+        }
+        int child_status = 0;
+        waitpid(child, &child_status, 0);
+        if (!WIFEXITED(child_status) || WEXITSTATUS(child_status) == EXIT_SUCCESS || readFile(save_path) != bytes) {
+                ERROR("Corrupt Save Was Accepted or Modified");
+                return EXIT_FAILURE;
+        }
+
+        // Reaching max_records compacts the save down to one full record
+        std::filesystem::remove(save_path);
+        DapperCraft::details::BrickStorage compacted(round_trip_brick_count);
+        for (int i = 0; i < 5; i++)
+                saveSession(save_path, compacted, rng, 2);
+        if (recordSize(readFile(save_path), 0) != std::filesystem::file_size(save_path) || !loadsAs(save_path, compacted)) {
+                ERROR("Save Was Not Compacted");
+                return EXIT_FAILURE;
+        }
+
+        // A world at the 32-bit brick index limit must not wrap its page count and drop edits
+        std::filesystem::remove(save_path);
+        DapperCraft::details::BrickStorage limit(UINT32_MAX);
+        DapperCraft::details::Brick brick;
+        brick.voxels.fill(7);
+        limit.setBrick(0, brick);
+        limit.setBrick(UINT32_MAX - 1, brick);
+        {
+                DapperCraft::details::BrickAutosaver autosaver(save_path);
+                autosaver.autosave(limit.snapshot());
+        }
+        DapperCraft::details::BrickStorage limit_loaded(UINT32_MAX);
+        if (!DapperCraft::details::BrickAutosaver::load(save_path, limit_loaded) || limit_loaded.version() != limit.version()
+            || limit_loaded.brick(0).voxels != brick.voxels || limit_loaded.brick(UINT32_MAX - 1).voxels != brick.voxels
+            || limit_loaded.brickVersion(UINT32_MAX - 1) != limit.brickVersion(UINT32_MAX - 1)) {
+                ERROR("Near-Limit World Did Not Round Trip");
+                return EXIT_FAILURE;
+        }
+
+        std::filesystem::remove(save_path);
+        INFO("Brick Autosave Round Trip Passed");
+        return EXIT_SUCCESS;
+}